@@ -0,0 +1,15 @@
+#include "Binary.h"
+
+parser_type<std::string_view> take(size_t n)
+{
+    return {[n](parsing_state ps)
+            {
+                data_stream &ds = ps._ds;
+                if (!ds) return fail<std::string_view>("no parsing data")(ps);
+                if (!ps.is_valid()) return fail<std::string_view>("invalid state")(ps);
+                if (!ds.has(n)) return fail<std::string_view>("expected " + std::to_string(n) + " bytes")(ps);
+                std::string_view out(ds.ptr(), n);
+                ds.jump(n);
+                return parser_out<std::string_view>(std::make_unique<std::string_view>(out), ps);
+            }};
+}
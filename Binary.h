@@ -0,0 +1,79 @@
+#ifndef BINARY_H
+#define BINARY_H
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include "Parsing.h"
+
+/*
+ * Byte-level parsers for binary and mixed text/binary framing
+ * meant for length-bounded input: run_parser(parser, data, length)
+ * the cursor is moved with data_stream::jump, in O(1) whatever the size of the field
+ */
+
+//assembles a fixed-width integer from bytes in the given order, compiles to a plain (byteswapped) load
+template<class T, bool little_endian>
+T load_int(const char *p)
+{
+    using U = std::make_unsigned_t<T>;
+    U v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        U b = static_cast<unsigned char>(p[little_endian ? i : sizeof(T) - 1 - i]);
+        v = static_cast<U>(v | (b << (8 * i)));
+    }
+    return static_cast<T>(v);
+}
+
+template<class T, bool little_endian>
+parser_out<T> p_fixed_int(parsing_state ps)
+{
+    static_assert(std::is_integral_v<T>);
+    data_stream &ds = ps._ds;
+    if (!ds) return fail<T>("no parsing data")(ps);
+    if (!ps.is_valid()) return fail<T>("invalid state")(ps);
+    if (!ds.has(sizeof(T))) return fail<T>("expected " + std::to_string(sizeof(T)) + " bytes")(ps);
+    T value = load_int<T, little_endian>(ds.ptr());
+    ds.jump(sizeof(T));
+    return parser_out<T>(std::make_unique<T>(value), ps);
+}
+
+//little-endian integer of sizeof(T) bytes
+template<class T>
+parser_type<T> p_le{p_fixed_int<T, true>};
+
+//big-endian (network order) integer of sizeof(T) bytes
+template<class T>
+parser_type<T> p_be{p_fixed_int<T, false>};
+
+//next n bytes as a view into the input, no copy
+parser_type<std::string_view> take(size_t n);
+
+/*
+ * length-prefixed block: len_parser reads the length, body_parser runs on exactly that many bytes
+ * and cannot see past them; afterwards the cursor jumps to the end of the block
+ * even if the body did not consume all of it.
+ */
+template<class L, class T>
+parser_type<T> length_prefixed(const parser_type<L> &len_parser, const parser_type<T> &body_parser)
+{
+    static_assert(std::is_integral_v<L>);
+    return {[len_parser, body_parser](parsing_state ps)
+            {
+                parser_out<L> len = len_parser(ps);
+                if (!len.second.is_valid()) return parser_out<T>(std::unique_ptr<T>(), len.second);
+                ps = len.second;
+                bool negative = false;
+                if constexpr (std::is_signed_v<L>) negative = *len.first < 0;
+                if (negative || !ps._ds.has(static_cast<size_t>(*len.first)))
+                    return fail<T>("length prefix " + std::to_string(*len.first) + " exceeds the input")(ps);
+                auto n = static_cast<size_t>(*len.first);
+                parser_out<T> body = body_parser(parsing_state(ps._ds.limit(n), ps._pfd));
+                if (!body.second.is_valid()) return body;
+                ps._ds.jump(n);
+                return parser_out<T>(std::move(body.first), ps);
+            }};
+}
+
+#endif /***BINARY_H***/
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_set>
+#include "Lexer.h"
+
+char_class::char_class(char c)
+{
+    bits.set(static_cast<unsigned char>(c));
+}
+
+char_class::char_class(const function<bool(char)>& predicate)
+{
+    for (int c = 0; c < 256; ++c)
+    {
+        if (predicate(static_cast<char>(c))) bits.set(c);
+    }
+}
+
+lex_pattern operator+(lex_pattern a, const lex_pattern& b)
+{
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+}
+
+lex_pattern lex_char(char c)
+{
+    return {{char_class(c), lex_item::one}};
+}
+
+lex_pattern lex_char(const function<bool(char)>& predicate)
+{
+    return {{char_class(predicate), lex_item::one}};
+}
+
+lex_pattern lex_string(const std::string& s)
+{
+    lex_pattern out;
+    for (char c: s) out.push_back({char_class(c), lex_item::one});
+    return out;
+}
+
+lex_pattern lex_many(const function<bool(char)>& predicate)
+{
+    return {{char_class(predicate), lex_item::star}};
+}
+
+lex_pattern lex_many1(const function<bool(char)>& predicate)
+{
+    char_class chars(predicate);
+    return {{chars, lex_item::one}, {chars, lex_item::star}};
+}
+
+lex_pattern lex_optional(const function<bool(char)>& predicate)
+{
+    return {{char_class(predicate), lex_item::optional}};
+}
+
+int token_stream::kind(size_t i) const
+{
+    auto b = static_cast<unsigned char>(_kinds[i]);
+    return b < 10 ? b - 1 : b - 2;
+}
+
+std::pair<int, int> token_stream::position(size_t i) const
+{
+    return location(i < _offsets.size() ? _offsets[i] : (_offsets.empty() ? 0 : _offsets.back() + _lengths.back()));
+}
+
+std::pair<int, int> token_stream::location(uint32_t offset) const
+{
+    auto line = std::upper_bound(_line_starts.begin(), _line_starts.end(), offset) - 1;
+    return {static_cast<int>(line - _line_starts.begin()) + 1, static_cast<int>(offset - *line) + 1};
+}
+
+int lexer::rule(const lex_pattern& pattern)
+{
+    _rules.push_back({pattern, false});
+    return static_cast<int>(_rules.size()) - 1;
+}
+
+void lexer::skip(const lex_pattern& pattern)
+{
+    _rules.push_back({pattern, true});
+}
+
+/*
+ * Subset construction over the position automaton of the rules:
+ * NFA state (r, i) means "rule r has matched its first i items".
+ */
+bool lexer::compile()
+{
+    if (_rules.size() > static_cast<size_t>(max_kinds)) return false;
+    using nfa_state = std::pair<uint32_t, uint32_t>;
+    using nfa_set = std::vector<nfa_state>;
+
+    auto closure = [this](nfa_set set)
+    {
+        for (size_t k = 0; k < set.size(); ++k)
+        {
+            auto [r, i] = set[k];
+            const lex_pattern& items = _rules[r].items;
+            if (i < items.size() && items[i].rep != lex_item::one) set.emplace_back(r, i + 1);
+        }
+        std::sort(set.begin(), set.end());
+        set.erase(std::unique(set.begin(), set.end()), set.end());
+        return set;
+    };
+    auto accepted = [this](const nfa_set& set)
+    {
+        for (auto [r, i]: set)
+        {
+            if (i == _rules[r].items.size()) return static_cast<int>(r);
+        }
+        return -1;
+    };
+
+    nfa_set start;
+    for (uint32_t r = 0; r < _rules.size(); ++r) start.emplace_back(r, 0);
+    start = closure(start);
+    if (accepted(start) != -1) return false;
+
+    std::map<nfa_set, uint32_t> ids{{nfa_set(), 0}, {start, 1}};
+    std::vector<nfa_set> sets{nfa_set(), start};
+    _next.assign(2 * 256, 0);
+    _accept = {-1, -1};
+    for (uint32_t s = 1; s < sets.size(); ++s)
+    {
+        for (int c = 0; c < 256; ++c)
+        {
+            nfa_set moved;
+            for (auto [r, i]: sets[s])
+            {
+                const lex_pattern& items = _rules[r].items;
+                if (i == items.size() || !items[i].chars[static_cast<unsigned char>(c)]) continue;
+                moved.emplace_back(r, items[i].rep == lex_item::star ? i : i + 1);
+            }
+            moved = closure(std::move(moved));
+            auto found = ids.find(moved);
+            if (found == ids.end())
+            {
+                found = ids.emplace(moved, static_cast<uint32_t>(sets.size())).first;
+                sets.push_back(moved);
+                _next.resize(_next.size() + 256, 0);
+                _accept.push_back(accepted(moved));
+            }
+            _next[s * 256 + c] = found->second;
+        }
+    }
+    return true;
+}
+
+Maybe<token_stream> lexer::tokenize(const char* input, size_t length) const
+{
+    if (length > UINT32_MAX) return Maybe<token_stream>::Left("lexing fail:\ninput longer than 4 GiB");
+    token_stream ts;
+    ts._input = input;
+    ts._line_starts.push_back(0);
+    for (const char* nl = input; (nl = static_cast<const char*>(memchr(nl, '\n', input + length - nl))); ++nl)
+    {
+        ts._line_starts.push_back(static_cast<uint32_t>(nl + 1 - input));
+    }
+    if (_accept.empty()) return Maybe<token_stream>::Left("lexer is not compiled");
+
+    /*
+     * (DFA state, position) pairs reached after the last accepting position of a scan lead to no match:
+     * the DFA is deterministic, so a later scan reaching one of them stops there. Every pair is walked
+     * past the end of a token at most once, which keeps the longest match linear overall.
+     */
+    std::unordered_set<uint64_t> dead_ends;
+    std::vector<uint64_t> trail;
+    size_t dead_ends_until = 0;     //largest position in dead_ends
+    auto key = [this](uint32_t state, size_t position) { return position * _accept.size() + state; };
+
+    size_t pos = 0;
+    while (pos < length)
+    {
+        if (pos > dead_ends_until) dead_ends.clear();
+        //longest match: run until the dead state, remember the last accepting position
+        uint32_t state = 1;
+        int rule = -1;
+        size_t end = pos;
+        trail.clear();
+        for (size_t i = pos; i < length; ++i)
+        {
+            state = _next[state * 256 + static_cast<unsigned char>(input[i])];
+            if (!state || dead_ends.count(key(state, i + 1))) break;
+            if (_accept[state] != -1)
+            {
+                rule = _accept[state];
+                end = i + 1;
+                trail.clear();
+            }
+            else trail.push_back(key(state, i + 1));
+        }
+        if (!trail.empty())
+        {
+            dead_ends.insert(trail.begin(), trail.end());
+            dead_ends_until = std::max(dead_ends_until, static_cast<size_t>(trail.back() / _accept.size()));
+        }
+        if (rule == -1)
+        {
+            auto [line, col] = ts.location(static_cast<uint32_t>(pos));
+            std::stringstream s;
+            s << "lexing fail:\n(" << line << ":" << col << ") : " << input[pos] << ": unexpected character";
+            return Maybe<token_stream>::Left(s.str());
+        }
+        if (!_rules[rule].skip)
+        {
+            ts._kinds.push_back(token_stream::kind_byte(rule));
+            ts._offsets.push_back(static_cast<uint32_t>(pos));
+            ts._lengths.push_back(static_cast<uint32_t>(end - pos));
+        }
+        pos = end;
+    }
+    return Maybe<token_stream>::Right(std::move(ts));
+}
+
+Maybe<token_stream> lexer::tokenize(const char* input) const
+{
+    return tokenize(input, strlen(input));
+}
+
+parser_type<std::string_view> p_token(const token_stream& ts, int kind, const std::string& description)
+{
+    char expected = token_stream::kind_byte(kind);
+    return {[&ts, expected, description](parsing_state ps)
+            {
+                data_stream &ds = ps._ds;
+                if (!ds) return fail<std::string_view>("no parsing data")(ps);
+                if (!ps.is_valid()) return fail<std::string_view>("invalid state")(ps);
+                size_t i = ts.index(ds);
+                if (ps.is_EOF() || *ds != expected)
+                {
+                    auto [line, col] = ts.position(i);
+                    std::stringstream ss;
+                    ss << "(" << line << ":" << col << ") : ";
+                    if (ps.is_EOF()) ss << "EOF";
+                    else ss << ts.text(i);
+                    ss << ": expected " << description;
+                    ps.fault(ss.str(), false);
+                    return parser_out<std::string_view>(std::unique_ptr<std::string_view>(), ps);
+                }
+                ++ds;
+                return parser_out<std::string_view>(std::make_unique<std::string_view>(ts.text(i)), ps);
+            }};
+}
@@ -0,0 +1,131 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Parsing.h"
+
+/*
+ * Tokenizer stage
+ * token rules are written with the lex_* builders, which mirror p_char, p_string, many and many1.
+ * lexer::compile turns all of them into one DFA that splits the input in a single linear pass
+ * (longest match, the earlier rule wins a tie) into a token_stream.
+ * The token_stream is read through an ordinary data_stream holding one byte per token,
+ * so every combinator of Parsing.h works on tokens and backtracking moves between token indices.
+ */
+
+//set of bytes; built from a predicate by trying all 256 values
+struct char_class
+{
+    std::bitset<256> bits;
+
+    char_class() = default;
+
+    explicit char_class(char c);
+
+    explicit char_class(const function<bool(char)> &predicate);
+
+    bool operator[](unsigned char c) const { return bits[c]; }
+};
+
+struct lex_item
+{
+    enum repeat
+    {
+        one, optional, star
+    };
+    char_class chars;
+    repeat rep;
+};
+
+using lex_pattern = std::vector<lex_item>;
+
+lex_pattern operator+(lex_pattern a, const lex_pattern &b);
+
+//a given char
+lex_pattern lex_char(char c);
+
+//any char obeys given predicate
+lex_pattern lex_char(const function<bool(char)> &predicate);
+
+//given string of symbols
+lex_pattern lex_string(const std::string &s);
+
+//zero or more chars satisfied to the predicate
+lex_pattern lex_many(const function<bool(char)> &predicate);
+
+//one or more chars satisfied to the predicate
+lex_pattern lex_many1(const function<bool(char)> &predicate);
+
+//zero or one char satisfied to the predicate
+lex_pattern lex_optional(const function<bool(char)> &predicate);
+
+class token_stream
+{
+    friend class lexer;
+
+    const char *_input = nullptr;
+    std::string _kinds;                 //one byte per token, read by the combinators through stream()
+    std::vector<uint32_t> _offsets;     //token i is [_offsets[i], _offsets[i] + _lengths[i]) of the input
+    std::vector<uint32_t> _lengths;
+    std::vector<uint32_t> _line_starts; //offsets of the first char of every input line
+public:
+    //byte the token kind is stored as; kinds never map to '\n', so the stream line stays 1
+    static char kind_byte(int kind) { return static_cast<char>(kind < 9 ? kind + 1 : kind + 2); }
+
+    //the token sequence as a parser input; valid as long as this object is neither moved nor destroyed
+    data_stream stream() const { return {_kinds.data(), _kinds.size()}; }
+
+    //index of the token the stream points at
+    size_t index(const data_stream &ds) const { return ds.ptr() - _kinds.data(); }
+
+    size_t size() const { return _kinds.size(); }
+
+    int kind(size_t i) const;
+
+    std::string_view text(size_t i) const { return {_input + _offsets[i], _lengths[i]}; }
+
+    //line and column of token i in the input, end of input for i == size()
+    std::pair<int, int> position(size_t i) const;
+
+    //line and column of a byte offset in the input
+    std::pair<int, int> location(uint32_t offset) const;
+};
+
+class lexer
+{
+    struct rule
+    {
+        lex_pattern items;
+        bool skip;
+    };
+    std::vector<rule> _rules;
+    std::vector<uint32_t> _next;        //DFA transitions, 256 per state, state 0 is dead
+    std::vector<int> _accept;           //accepted rule of each DFA state or -1
+public:
+    static constexpr int max_kinds = 253;
+
+    //adds a token rule, returns its kind; fails the compilation of patterns that match the empty string
+    int rule(const lex_pattern &pattern);
+
+    //adds a rule whose matches are dropped (white space, comments)
+    void skip(const lex_pattern &pattern);
+
+    //builds the DFA, false if there are too many rules or a rule can match nothing
+    bool compile();
+
+    size_t states() const { return _accept.size(); }
+
+    //offsets are 32-bit, longer input is rejected
+    Maybe<token_stream> tokenize(const char *input, size_t length) const;
+
+    Maybe<token_stream> tokenize(const char *input) const;
+};
+
+//parse one token of the given kind, return its text
+parser_type<std::string_view> p_token(const token_stream &ts, int kind, const std::string &description);
+
+#endif /***LEXER_H***/
@@ -0,0 +1,248 @@
+#ifndef LITERALS_H
+#define LITERALS_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include "Parsing.h"
+
+/*
+ * Compile-time literals and static rules
+ * the text of lit<"..."> and ch<'c'> is a template constant, so matching compiles to fixed compares
+ * (8- and 4-byte words when the input length is known) and fault messages are built while compiling.
+ * Rules composed of static parts only (ch_t, lit_t, range_t, seq_t, alt_t, opt_t, many_t, many1_t)
+ * are checked while compiling too: a many over something that can match nothing does not compile.
+ */
+
+//string literal usable as a template argument
+template<size_t N>
+struct fixed_string
+{
+    char data[N] {};
+
+    constexpr fixed_string() = default;
+
+    constexpr fixed_string(const char (&s)[N])
+    {
+        for (size_t i = 0; i < N; ++i) data[i] = s[i];
+    }
+
+    static constexpr size_t size() { return N - 1; }
+};
+
+template<size_t N, size_t M>
+constexpr fixed_string<N + M - 1> operator+(const fixed_string<N> &a, const fixed_string<M> &b)
+{
+    fixed_string<N + M - 1> out;
+    for (size_t i = 0; i < N - 1; ++i) out.data[i] = a.data[i];
+    for (size_t i = 0; i < M; ++i) out.data[N - 1 + i] = b.data[i];
+    return out;
+}
+
+//compares p with S from offset I on: 8-byte words, then a 4-byte word, then single bytes
+template<fixed_string S, size_t I = 0>
+bool match_words(const char *p)
+{
+    constexpr size_t n = S.size();
+    if constexpr (I + 8 <= n)
+    {
+        uint64_t a, b;
+        memcpy(&a, p + I, 8);
+        memcpy(&b, S.data + I, 8);
+        return a == b && match_words<S, I + 8>(p);
+    }
+    else if constexpr (I + 4 <= n)
+    {
+        uint32_t a, b;
+        memcpy(&a, p + I, 4);
+        memcpy(&b, S.data + I, 4);
+        return a == b && match_words<S, I + 4>(p);
+    }
+    else if constexpr (I < n) return p[I] == S.data[I] && match_words<S, I + 1>(p);
+    else return true;
+}
+
+//compares the input at ds with S; word compares need the input length, otherwise bytes stop at the first mismatch
+template<fixed_string S>
+bool match_literal(const data_stream &ds)
+{
+    constexpr size_t n = S.size();
+    const char *p = ds.ptr();
+    if (ds.end()) return ds.has(n) && match_words<S>(p);
+    return [p]<size_t... I>(std::index_sequence<I...>)
+    {
+        return ((p[I] == S.data[I]) && ...);
+    }(std::make_index_sequence<n>());
+}
+
+/*
+ * static rules
+ * every rule has min_length (fewest chars it can match), a description for fault messages
+ * and match(ds), which advances ds on success; on failure ds is left anywhere and the caller restores it
+ */
+
+template<char C>
+struct ch_t
+{
+    static constexpr size_t min_length = 1;
+    static constexpr fixed_string<2> description{{C, '\0'}};
+
+    static bool match(data_stream &ds)
+    {
+        if (ds.at_end() || *ds != C) return false;
+        ++ds;
+        return true;
+    }
+};
+
+template<fixed_string S>
+struct lit_t
+{
+    static_assert(S.size() > 0, "empty literal matches nothing");
+    static constexpr size_t min_length = S.size();
+    static constexpr auto description = S;
+
+    static bool match(data_stream &ds)
+    {
+        if (!match_literal<S>(ds)) return false;
+        ds.skip(S.size());
+        return true;
+    }
+};
+
+//one char in [From, To]
+template<char From, char To>
+struct range_t
+{
+    static_assert(From <= To, "empty char range");
+    static constexpr size_t min_length = 1;
+    static constexpr fixed_string<6> description{{'[', From, '-', To, ']', '\0'}};
+
+    static bool match(data_stream &ds)
+    {
+        char c = *ds;
+        if (ds.at_end() || c < From || c > To) return false;
+        ++ds;
+        return true;
+    }
+};
+
+template<fixed_string Separator, class P, class... Ps>
+constexpr auto join_descriptions()
+{
+    if constexpr (sizeof...(Ps) == 0) return P::description;
+    else return P::description + Separator + join_descriptions<Separator, Ps...>();
+}
+
+template<class... Ps>
+struct seq_t
+{
+    static_assert(sizeof...(Ps) > 0, "empty sequence");
+    static constexpr size_t min_length = (Ps::min_length + ...);
+    static constexpr auto description = join_descriptions<" ", Ps...>();
+
+    static bool match(data_stream &ds)
+    {
+        return (Ps::match(ds) && ...);
+    }
+};
+
+//first matching alternative, no backtracking into it afterwards
+template<class... Ps>
+struct alt_t
+{
+    static_assert(sizeof...(Ps) > 0, "empty choice");
+    static constexpr size_t min_length = std::min({Ps::min_length...});
+    static constexpr auto description = fixed_string("(") + join_descriptions<" or ", Ps...>() + fixed_string(")");
+
+    static bool match(data_stream &ds)
+    {
+        data_stream start = ds;
+        return ((ds = start, Ps::match(ds)) || ...);
+    }
+};
+
+template<class P>
+struct opt_t
+{
+    static constexpr size_t min_length = 0;
+    static constexpr auto description = P::description + fixed_string("?");
+
+    static bool match(data_stream &ds)
+    {
+        data_stream start = ds;
+        if (!P::match(ds)) ds = start;
+        return true;
+    }
+};
+
+template<class P>
+struct many_t
+{
+    static_assert(P::min_length > 0, "many over a rule that can match nothing never ends");
+    static constexpr size_t min_length = 0;
+    static constexpr auto description = P::description + fixed_string("*");
+
+    static bool match(data_stream &ds)
+    {
+        data_stream last = ds;
+        while (P::match(ds)) last = ds;
+        ds = last;
+        return true;
+    }
+};
+
+template<class P>
+struct many1_t
+{
+    static_assert(P::min_length > 0, "many1 over a rule that can match nothing never ends");
+    static constexpr size_t min_length = P::min_length;
+    static constexpr auto description = P::description + fixed_string("+");
+
+    static bool match(data_stream &ds)
+    {
+        if (!P::match(ds)) return false;
+        return many_t<P>::match(ds);
+    }
+};
+
+template<class Rule>
+parser_out<std::string> parse_rule(parsing_state ps)
+{
+    static constexpr auto message = fixed_string("expected ") + Rule::description;
+    data_stream &ds = ps._ds;
+    if (!ds) return fail<std::string>("no parsing data")(ps);
+    if (!ps.is_valid()) return fail<std::string>("invalid state")(ps);
+    data_stream start = ds;
+    if (!Rule::match(ds))
+    {
+        ds = start;
+        return fail<std::string>(message.data)(ps);
+    }
+    return parser_out<std::string>(std::make_unique<std::string>(start.ptr(), ds.ptr()), ps);
+}
+
+//parse a static rule, return the text it matched
+template<class Rule>
+parser_type<std::string> rule{parse_rule<Rule>};
+
+//parse a literal known at compile time, e.g. lit<"&apos">
+template<fixed_string S>
+parser_type<std::string> lit{parse_rule<lit_t<S>>};
+
+//parse a char known at compile time, e.g. ch<'='>
+template<char C>
+parser_type<char> ch{[](parsing_state ps)
+                     {
+                         static constexpr auto message = fixed_string("expected ") + ch_t<C>::description;
+                         data_stream &ds = ps._ds;
+                         if (!ds) return fail<char>("no parsing data")(ps);
+                         if (ps.is_EOF()) return fail<char>("end of input")(ps);
+                         if (!ps.is_valid()) return fail<char>("invalid state")(ps);
+                         if (*ds != C) return fail<char>(message.data)(ps);
+                         ++ds;
+                         return parser_out<char>(std::make_unique<char>(C), ps);
+                     }};
+
+#endif /***LITERALS_H***/
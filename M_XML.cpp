@@ -1,25 +1,19 @@
 #include "M_XML.h"
+#include "M_XMLWriter.h"
+#include "Literals.h"
 
 std::ostream& operator<<(std::ostream& o, const XMLTag& tag)
 {
-    o << tag.name << "=\"" << tag.value << "\"";
-    return o;
+    XMLWriter w(XMLWriterOptions{-1, false});
+    auto out = w.write(tag).view();
+    return o.write(out.data(), static_cast<std::streamsize>(out.size()));
 }
 
 std::ostream& operator<<(std::ostream& o, const XML& s)
 {
-    s.listtagsshow(o << s.spaces << "<" << s.blockname, s.tags);
-    if (s.subblocks.empty()) o << " />\n";
-    else
-    {
-        o << ">" << std::endl;
-        for (const auto& subblock: s.subblocks)
-        {
-            o << subblock;
-        }
-        o << s.spaces << "</" << s.blockname << ">" << std::endl;
-    }
-    return o;
+    XMLWriter w(XMLWriterOptions{-1, false});
+    auto out = w.write(s).view();
+    return o.write(out.data(), static_cast<std::streamsize>(out.size()));
 }
 
 std::ostream& XML::listtagsshow(std::ostream& o, const std::vector<XMLTag>& tags) const
@@ -33,28 +27,24 @@ std::ostream& XML::listtagsshow(std::ostream& o, const std::vector<XMLTag>& tags
 
 parser_out<char> p_space_or_tab(parsing_state ps)
 {
-    return (p_char(' ') || p_char('\t'))(ps);
+    return (ch<' '> || ch<'\t'>)(ps);
 }
 
 parser_out<char> p_alphanum(parsing_state ps)
 {
-    return (p_char([](char c) { return isalnum(c); }, "letter or digit"))(ps);
+    return (p_char([](char c) { return isalnum(static_cast<unsigned char>(c)) != 0; }, "letter or digit"))(ps);
 }
 
 parser_out<char> p_specsymbol(parsing_state ps)
 {
-    return (p_string("&apos") >> pure('"'))(ps);
+    return (lit<"&apos"> >> pure('"'))(ps);
 }
 
 std::string unspecsymbol(const std::string& in)
 {
-    std::string out;
-    for (const auto c: in)
-    {
-        if (c == '"') out += "&apos";
-        else out.push_back(c);
-    }
-    return out;
+    XMLWriter w;
+    auto out = w.escaped(in).view();
+    return std::string(out);
 }
 
 parser_out<std::string> p_whiteSpaces(parsing_state ps)
@@ -64,10 +54,10 @@ parser_out<std::string> p_whiteSpaces(parsing_state ps)
 
 parser_out<XMLTag> p_XMLTag(parsing_state ps)
 {
-    parser_type<std::string> tagName = many1(function(p_alphanum));
-    parser_type<std::string> tagValue =
-            function(p_whiteSpaces) >> p_char('=') >> function(p_whiteSpaces) >> p_char('"') >> p_until(p_char('"'));
+    //combinators keep references to their operands, so the grammar is built and run in one full-expression
     auto out = function(
             [](std::string name, std::string value, std::string spacesafter) { return XMLTag {name, value}; });
-    return (out/tagName*tagValue*function(p_whiteSpaces))(ps);
+    return (out / many1(function(p_alphanum)) *
+            (function(p_whiteSpaces) >> ch<'='> >> function(p_whiteSpaces) >> ch<'"'> >> p_until(ch<'"'>)) *
+            function(p_whiteSpaces))(ps);
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "M_XMLColumns.h"
+
+namespace
+{
+    bool is_space(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    void skip_spaces(data_stream& ds)
+    {
+        while (is_space(*ds)) ++ds;
+    }
+
+    //same name alphabet as p_XMLTag
+    std::string_view read_name(data_stream& ds)
+    {
+        const char* begin = ds.ptr();
+        while (isalnum(static_cast<unsigned char>(*ds))) ++ds;
+        return {begin, static_cast<size_t>(ds.ptr() - begin)};
+    }
+}
+
+std::string_view XMLColumns::attr(uint32_t i, std::string_view attr_name) const
+{
+    XMLName id = names.find(attr_name);
+    for (uint32_t a = attr_begin(i), e = attr_end(i); a < e; ++a)
+    {
+        if (attributes[a].name == id) return str(attributes[a].value);
+    }
+    return {};
+}
+
+std::vector<uint32_t> XMLColumns::find_all(std::string_view element) const
+{
+    std::vector<uint32_t> out;
+    XMLName id = names.find(element);
+    if (id == XMLNameTable::npos) return out;
+    for (uint32_t i = 0; i < nodes.size(); ++i)
+    {
+        if (nodes[i].name == id) out.push_back(i);
+    }
+    return out;
+}
+
+std::vector<std::string_view> XMLColumns::query(std::string_view element, std::string_view attr_name) const
+{
+    std::vector<std::string_view> out;
+    XMLName element_id = names.find(element);
+    XMLName attr_id = names.find(attr_name);
+    if (element_id == XMLNameTable::npos || attr_id == XMLNameTable::npos) return out;
+    uint32_t i = 0;
+    while (i < nodes.size())
+    {
+        if (nodes[i].name != element_id)
+        {
+            ++i;
+            continue;
+        }
+        //the whole subtree is one run of the attribute array; nested matches are covered by it
+        for (uint32_t a = attr_begin(i), e = subtree_attr_end(i); a < e; ++a)
+        {
+            if (attributes[a].name == attr_id) out.push_back(str(attributes[a].value));
+        }
+        i = nodes[i].end;
+    }
+    return out;
+}
+
+XML XMLColumns::to_XML(uint32_t i) const
+{
+    XML out{std::string(str(nodes[i].spaces)), names.str(nodes[i].name), {}, {}};
+    for_each_attribute(i, [&](const attribute& a)
+    {
+        out.tags.push_back({names.str(a.name), std::string(str(a.value))});
+    });
+    for_each_child(i, [&](uint32_t c) { out.subblocks.push_back(to_XML(c)); });
+    return out;
+}
+
+parser_out<XMLColumns> p_XMLColumns(parsing_state ps)
+{
+    if (!ps._ds) return fail<XMLColumns>("no parsing data")(ps);
+    if (!ps.is_valid()) return fail<XMLColumns>("invalid state")(ps);
+    data_stream& ds = ps._ds;
+    const char* base = ds.ptr();
+    auto offset = [base](const char* p) { return static_cast<uint32_t>(p - base); };
+    //spans are 32-bit, so are the offsets they are taken at
+    auto too_long = [&ds, base] { return static_cast<size_t>(ds.ptr() - base) > UINT32_MAX; };
+    auto error = [&ps](const std::string& why) { return fail<XMLColumns>(why)(ps); };
+
+    auto doc = std::make_unique<XMLColumns>();
+    auto& nodes = doc->nodes;
+    auto& attributes = doc->attributes;
+    std::vector<uint32_t> open;         //unclosed elements, innermost last
+    std::vector<uint32_t> last_child;   //last linked child of each open element
+    do
+    {
+        const char* ws_begin = ds.ptr();
+        skip_spaces(ds);
+        const char* indent = ds.ptr();
+        while (indent > ws_begin && indent[-1] != '\n') --indent;
+        if (*ds != '<') return error("expected <");
+        ++ds;
+
+        if (*ds == '/')
+        {
+            if (open.empty()) return error("unexpected closing tag");
+            ++ds;
+            uint32_t i = open.back();
+            if (doc->names.find(read_name(ds)) != nodes[i].name)
+                return error("expected </" + doc->names.str(nodes[i].name) + ">");
+            skip_spaces(ds);
+            if (*ds != '>') return error("expected >");
+            ++ds;
+            nodes[i].end = static_cast<uint32_t>(nodes.size());
+            open.pop_back();
+            last_child.pop_back();
+            continue;
+        }
+
+        std::string_view name = read_name(ds);
+        if (name.empty()) return error("expected element name");
+        if (too_long()) return error("document longer than 4 GiB");
+        auto i = static_cast<uint32_t>(nodes.size());
+        XMLColumns::node n;
+        n.name = doc->names.intern(name);
+        n.first_attr = static_cast<uint32_t>(attributes.size());
+        n.spaces = {offset(indent), offset(ds.ptr() - name.size() - 1) - offset(indent)};
+        if (!open.empty())
+        {
+            n.parent = open.back();
+            if (last_child.back() == XMLColumns::none) nodes[n.parent].first_child = i;
+            else nodes[last_child.back()].next_sibling = i;
+            last_child.back() = i;
+        }
+        nodes.push_back(n);
+
+        for (;;)
+        {
+            skip_spaces(ds);
+            if (*ds == '>')
+            {
+                ++ds;
+                open.push_back(i);
+                last_child.push_back(XMLColumns::none);
+                break;
+            }
+            if (*ds == '/')
+            {
+                ++ds;
+                if (*ds != '>') return error("expected />");
+                ++ds;
+                nodes[i].end = i + 1;
+                break;
+            }
+            std::string_view attr_name = read_name(ds);
+            if (attr_name.empty()) return error("expected attribute name, > or />");
+            skip_spaces(ds);
+            if (*ds != '=') return error("expected =");
+            ++ds;
+            skip_spaces(ds);
+            if (*ds != '"') return error("expected \"");
+            ++ds;
+            const char* value = ds.ptr();
+            while (*ds != '"')
+            {
+                if (ps.is_EOF()) return error("unterminated attribute value");
+                ++ds;
+            }
+            if (too_long()) return error("document longer than 4 GiB");
+            attributes.push_back({doc->names.intern(attr_name), i, {offset(value), offset(ds.ptr()) - offset(value)}});
+            ++ds;
+        }
+    } while (!open.empty());
+
+    if (too_long()) return error("document longer than 4 GiB");
+    doc->input = std::string_view(base, offset(ds.ptr()));
+    return parser_out<XMLColumns>(std::move(doc), ps);
+}
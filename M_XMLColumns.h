@@ -0,0 +1,93 @@
+#ifndef M_XMLCOLUMNS_H
+#define M_XMLCOLUMNS_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "M_XMLNames.h"
+
+//[begin, begin + length) of the original input
+struct XMLSpan
+{
+    uint32_t begin = 0, length = 0;
+};
+
+/*
+ * Flat (struct-of-arrays) XML document
+ * nodes are stored in document order, so the subtree of a node is the index range [i, node.end)
+ * and the attributes of that subtree are a contiguous range of the attribute array.
+ * Attribute values and indentation are not copied: they are spans into the parsed input,
+ * which must outlive the document. Spans are 32-bit: p_XMLColumns fails on a document over 4 GiB.
+ */
+class XMLColumns
+{
+public:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    struct node
+    {
+        XMLName name;
+        uint32_t parent = none, first_child = none, next_sibling = none;
+        uint32_t end = 0;           //one past the last descendant
+        uint32_t first_attr = 0;    //attributes are [first_attr, nodes[i + 1].first_attr)
+        XMLSpan spaces;             //indentation in front of the opening tag
+    };
+
+    struct attribute
+    {
+        XMLName name;
+        uint32_t owner = none;
+        XMLSpan value;              //raw, &apos is not decoded
+    };
+
+    std::string_view input;
+    XMLNameTable names;
+    std::vector<node> nodes;
+    std::vector<attribute> attributes;
+
+    std::string_view str(XMLSpan span) const { return input.substr(span.begin, span.length); }
+
+    std::string_view name(uint32_t i) const { return names.str(nodes[i].name); }
+
+    uint32_t attr_begin(uint32_t i) const { return nodes[i].first_attr; }
+
+    uint32_t attr_end(uint32_t i) const
+    {
+        return i + 1 < nodes.size() ? nodes[i + 1].first_attr : static_cast<uint32_t>(attributes.size());
+    }
+
+    //attributes of the whole subtree of node i
+    uint32_t subtree_attr_end(uint32_t i) const
+    {
+        return nodes[i].end < nodes.size() ? nodes[nodes[i].end].first_attr : static_cast<uint32_t>(attributes.size());
+    }
+
+    //value of the first attribute of node i with the given name, empty view if there is none
+    std::string_view attr(uint32_t i, std::string_view attr_name) const;
+
+    template<class F>
+    void for_each_child(uint32_t i, F f) const
+    {
+        for (uint32_t c = nodes[i].first_child; c != none; c = nodes[c].next_sibling) f(c);
+    }
+
+    template<class F>
+    void for_each_attribute(uint32_t i, F f) const
+    {
+        for (uint32_t a = attr_begin(i), e = attr_end(i); a < e; ++a) f(attributes[a]);
+    }
+
+    //every node with the given name, in document order
+    std::vector<uint32_t> find_all(std::string_view element) const;
+
+    //values of attribute `attr_name` on `element` nodes and on all of their descendants
+    std::vector<std::string_view> query(std::string_view element, std::string_view attr_name) const;
+
+    //rebuilds the pointer-based model of the subtree at node i
+    XML to_XML(uint32_t i = 0) const;
+};
+
+//parses one element with its subelements straight into the columnar form
+parser_out<XMLColumns> p_XMLColumns(parsing_state ps);
+
+#endif /***M_XMLCOLUMNS_H***/
@@ -0,0 +1,90 @@
+#include "M_XMLNames.h"
+
+XMLNameTable::XMLNameTable()
+{
+    _names.emplace_back();
+    _index.emplace(_names.back(), 0);
+}
+
+XMLNameTable::XMLNameTable(const XMLNameTable& other) : _names(other._names)
+{
+    for (uint32_t id = 0; id < _names.size(); ++id) _index.emplace(_names[id], id);
+}
+
+XMLNameTable& XMLNameTable::operator=(const XMLNameTable& other)
+{
+    if (this != &other) *this = XMLNameTable(other);
+    return *this;
+}
+
+XMLName XMLNameTable::intern(std::string_view name)
+{
+    auto found = _index.find(name);
+    if (found != _index.end()) return {found->second};
+    auto id = static_cast<uint32_t>(_names.size());
+    _names.emplace_back(name);
+    _index.emplace(_names.back(), id);
+    return {id};
+}
+
+XMLName XMLNameTable::find(std::string_view name) const
+{
+    auto found = _index.find(name);
+    if (found == _index.end()) return npos;
+    return {found->second};
+}
+
+const std::string& XMLNameTable::str(XMLName name) const
+{
+    return _names.at(name.id);
+}
+
+const InternedXMLTag* InternedXML::tag(XMLName name) const
+{
+    for (const auto& t: tags)
+    {
+        if (t.name == name) return &t;
+    }
+    return nullptr;
+}
+
+InternedXMLTag intern(const XMLTag& tag, XMLNameTable& names)
+{
+    return {names.intern(tag.name), tag.value};
+}
+
+InternedXML intern(const XML& xml, XMLNameTable& names)
+{
+    InternedXML out{xml.spaces, names.intern(xml.blockname), {}, {}};
+    out.tags.reserve(xml.tags.size());
+    for (const auto& tag: xml.tags) out.tags.push_back(intern(tag, names));
+    out.subblocks.reserve(xml.subblocks.size());
+    for (const auto& subblock: xml.subblocks) out.subblocks.push_back(intern(subblock, names));
+    return out;
+}
+
+XMLTag expand(const InternedXMLTag& tag, const XMLNameTable& names)
+{
+    return {names.str(tag.name), tag.value};
+}
+
+XML expand(const InternedXML& xml, const XMLNameTable& names)
+{
+    XML out{xml.spaces, names.str(xml.blockname), {}, {}};
+    out.tags.reserve(xml.tags.size());
+    for (const auto& tag: xml.tags) out.tags.push_back(expand(tag, names));
+    out.subblocks.reserve(xml.subblocks.size());
+    for (const auto& subblock: xml.subblocks) out.subblocks.push_back(expand(subblock, names));
+    return out;
+}
+
+parser_type<InternedXMLTag> p_InternedXMLTag(XMLNameTable& names)
+{
+    return {[&names](parsing_state ps)
+            {
+                parser_out<XMLTag> tag = p_XMLTag(ps);
+                std::unique_ptr<InternedXMLTag> out;
+                if (tag.second.is_valid()) out = std::make_unique<InternedXMLTag>(intern(*tag.first, names));
+                return parser_out<InternedXMLTag>(std::move(out), tag.second);
+            }};
+}
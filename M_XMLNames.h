@@ -0,0 +1,94 @@
+#ifndef M_XMLNAMES_H
+#define M_XMLNAMES_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "M_XML.h"
+
+/*
+ * Interned element or attribute name
+ * a 4-byte id into XMLNameTable, compared and hashed as an integer
+ */
+struct XMLName
+{
+    uint32_t id = 0;
+
+    bool operator==(XMLName o) const { return id == o.id; }
+
+    bool operator!=(XMLName o) const { return id != o.id; }
+
+    bool operator<(XMLName o) const { return id < o.id; }
+};
+
+template<>
+struct std::hash<XMLName>
+{
+    size_t operator()(XMLName n) const noexcept { return n.id; }
+};
+
+/*
+ * String table resolving names to ids once
+ * id 0 is always the empty name, ids are dense and never reused
+ */
+class XMLNameTable
+{
+    std::deque<std::string> _names;                            //stable storage, index == id
+    std::unordered_map<std::string_view, uint32_t> _index;     //views into _names
+public:
+    static constexpr XMLName npos{UINT32_MAX};
+
+    XMLNameTable();
+
+    //the index holds views into the storage, so copies rebuild it
+    XMLNameTable(const XMLNameTable& other);
+
+    XMLNameTable& operator=(const XMLNameTable& other);
+
+    XMLNameTable(XMLNameTable&&) = default;
+
+    XMLNameTable& operator=(XMLNameTable&&) = default;
+
+    //returns the id of the name, adding it on first sight
+    XMLName intern(std::string_view name);
+
+    //returns the id of an already known name or npos, never grows the table
+    XMLName find(std::string_view name) const;
+
+    const std::string& str(XMLName name) const;
+
+    size_t size() const { return _names.size(); }
+};
+
+struct InternedXMLTag
+{
+    XMLName name;
+    std::string value;
+};
+
+struct InternedXML
+{
+    std::string spaces;
+    XMLName blockname;
+    std::vector<InternedXMLTag> tags;
+    std::vector<InternedXML> subblocks;
+
+    //first attribute with the given name or nullptr
+    const InternedXMLTag* tag(XMLName name) const;
+};
+
+InternedXMLTag intern(const XMLTag& tag, XMLNameTable& names);
+
+InternedXML intern(const XML& xml, XMLNameTable& names);
+
+XMLTag expand(const InternedXMLTag& tag, const XMLNameTable& names);
+
+XML expand(const InternedXML& xml, const XMLNameTable& names);
+
+//same grammar as p_XMLTag, but the name is resolved through the table while parsing
+parser_type<InternedXMLTag> p_InternedXMLTag(XMLNameTable& names);
+
+#endif /***M_XMLNAMES_H***/
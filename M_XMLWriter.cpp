@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "M_XMLWriter.h"
+
+XMLWriter::XMLWriter(XMLWriterOptions options) : _own(256, '\0'), _data(_own.data()), _capacity(_own.size()),
+                                                 _growable(true), _options(options) { }
+
+XMLWriter::XMLWriter(char* buffer, size_t capacity, XMLWriterOptions options) : _data(buffer), _capacity(capacity),
+                                                                                _growable(false), _options(options) { }
+
+XMLWriter::XMLWriter(int fd, size_t buffer_size, XMLWriterOptions options) : _own(buffer_size ? buffer_size : 1, '\0'),
+                                                                             _data(_own.data()),
+                                                                             _capacity(_own.size()), _fd(fd),
+                                                                             _growable(false), _options(options) { }
+
+XMLWriter::~XMLWriter()
+{
+    flush();
+}
+
+bool XMLWriter::flush()
+{
+    if (_fd < 0) return _good;
+    const char* p = _data;
+    while (_good && p < _data + _size)
+    {
+        ssize_t written = ::write(_fd, p, _data + _size - p);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) _good = false;
+        else p += written;
+    }
+    _size = 0;
+    return _good;
+}
+
+//makes place for n more bytes, false if the sink cannot take them into the buffer
+bool XMLWriter::room(size_t n)
+{
+    if (_size + n <= _capacity) return true;
+    if (_growable)
+    {
+        _own.resize(std::max(_own.size() * 2, _size + n));
+        _data = _own.data();
+        _capacity = _own.size();
+        return true;
+    }
+    if (_fd >= 0)
+    {
+        flush();
+        return n <= _capacity;
+    }
+    _good = false;
+    return false;
+}
+
+XMLWriter& XMLWriter::raw(std::string_view s)
+{
+    if (!_good) return *this;
+    if (room(s.size()))
+    {
+        memcpy(_data + _size, s.data(), s.size());
+        _size += s.size();
+    }
+    else if (_fd >= 0)
+    {
+        //larger than the whole buffer: the buffer is already flushed, write through
+        for (const char* p = s.data(); _good && p < s.data() + s.size();)
+        {
+            ssize_t written = ::write(_fd, p, s.data() + s.size() - p);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) _good = false;
+            else p += written;
+        }
+    }
+    return *this;
+}
+
+XMLWriter& XMLWriter::put(char c)
+{
+    if (_good && room(1)) _data[_size++] = c;
+    return *this;
+}
+
+XMLWriter& XMLWriter::escaped(std::string_view s)
+{
+    const char* p = s.data();
+    const char* end = p + s.size();
+    while (p < end)
+    {
+        auto q = static_cast<const char*>(memchr(p, '"', end - p));
+        if (!q)
+        {
+            raw({p, static_cast<size_t>(end - p)});
+            break;
+        }
+        raw({p, static_cast<size_t>(q - p)});
+        raw("&apos");
+        p = q + 1;
+    }
+    return *this;
+}
+
+void XMLWriter::attribute(const XMLTag& tag)
+{
+    raw(tag.name).raw("=\"");
+    if (_options.escape) escaped(tag.value);
+    else raw(tag.value);
+    put('"');
+}
+
+//the view into _spaces is invalidated by deeper levels growing it, so it is taken right before use
+std::string_view XMLWriter::spaces(const XML& xml, int depth)
+{
+    if (_options.indent < 0) return xml.spaces;
+    auto width = static_cast<size_t>(depth * _options.indent);
+    if (_spaces.size() < width) _spaces.resize(width, ' ');
+    return std::string_view(_spaces).substr(0, width);
+}
+
+void XMLWriter::element(const XML& xml, int depth)
+{
+    raw(spaces(xml, depth)).put('<').raw(xml.blockname);
+    for (const auto& tag: xml.tags)
+    {
+        put(' ');
+        attribute(tag);
+    }
+    if (xml.subblocks.empty())
+    {
+        raw(" />\n");
+        return;
+    }
+    raw(">\n");
+    for (const auto& subblock: xml.subblocks) element(subblock, depth + 1);
+    raw(spaces(xml, depth)).raw("</").raw(xml.blockname).raw(">\n");
+}
+
+XMLWriter& XMLWriter::write(const XML& xml)
+{
+    element(xml, 0);
+    return *this;
+}
+
+XMLWriter& XMLWriter::write(const XMLTag& tag)
+{
+    attribute(tag);
+    return *this;
+}
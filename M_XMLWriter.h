@@ -0,0 +1,74 @@
+#ifndef M_XMLWRITER_H
+#define M_XMLWRITER_H
+
+#include <string>
+#include <string_view>
+#include "M_XML.h"
+
+struct XMLWriterOptions
+{
+    int indent = -1;        //spaces per nesting level, -1 keeps XML::spaces of every node
+    bool escape = true;     //write '"' in attribute values as &apos (see unspecsymbol)
+};
+
+/*
+ * Buffered XML serializer
+ * writes into one of three sinks:
+ *  - its own growable buffer
+ *  - a caller-provided buffer of fixed capacity (good() turns false when it overflows)
+ *  - a file descriptor, flushed whenever the internal buffer fills up and on destruction
+ * escaping scans whole runs with memchr and copies them in bulk.
+ */
+class XMLWriter
+{
+    std::string _own;           //storage in the growable and fd modes
+    std::string _spaces;        //indentation source when options.indent >= 0
+    char* _data;
+    size_t _size = 0, _capacity;
+    int _fd = -1;
+    bool _growable;
+    bool _good = true;
+    XMLWriterOptions _options;
+
+    bool room(size_t n);
+
+    std::string_view spaces(const XML& xml, int depth);
+
+    void element(const XML& xml, int depth);
+
+    void attribute(const XMLTag& tag);
+
+public:
+    explicit XMLWriter(XMLWriterOptions options = {});
+
+    XMLWriter(char* buffer, size_t capacity, XMLWriterOptions options = {});
+
+    XMLWriter(int fd, size_t buffer_size, XMLWriterOptions options = {});
+
+    XMLWriter(const XMLWriter&) = delete;
+
+    XMLWriter& operator=(const XMLWriter&) = delete;
+
+    ~XMLWriter();
+
+    XMLWriter& write(const XML& xml);
+
+    XMLWriter& write(const XMLTag& tag);
+
+    XMLWriter& raw(std::string_view s);
+
+    XMLWriter& escaped(std::string_view s);
+
+    XMLWriter& put(char c);
+
+    //fd mode: writes the buffered bytes out, other modes: no-op
+    bool flush();
+
+    //false after a caller buffer overflow or a failed write to the fd
+    bool good() const { return _good; }
+
+    //bytes not yet flushed
+    std::string_view view() const { return {_data, _size}; }
+};
+
+#endif /***M_XMLWRITER_H***/
@@ -1,3 +1,5 @@
+#include <charconv>
+#include <cstring>
 #include "Parsing.h"
 
 parser_type<char> p_char(const char& t)
@@ -37,13 +39,22 @@ parser_type<std::string> many(const parser_type<char>& subparser)
     return {[&](parsing_state ps)
             {
                 std::string out;
+                bool outer_cut = ps._cut;
+                ps._cut = false;
                 parser_out<char> c = subparser(ps);
                 while (c.second.is_valid())
                 {
                     out.push_back(*c.first);
                     ps = c.second;
+                    ps._cut = false;
                     c = subparser(ps);
                 }
+                if (c.second._cut)
+                {
+                    c.second._cut = outer_cut;
+                    return parser_out<std::string>(std::unique_ptr<std::string>(), c.second);
+                }
+                ps._cut = outer_cut;
                 return parser_out<std::string>(std::make_unique<std::string>(out), ps);
             }};
 }
@@ -53,18 +64,34 @@ parser_type<std::string> many1(const parser_type<char>& subparser)
     return {[&](parsing_state ps)
             {
                 std::string out;
+                bool outer_cut = ps._cut;
+                ps._cut = false;
                 parser_out<char> c = subparser(ps);
                 if (!c.second.is_valid())
                 {
+                    if (c.second._cut)
+                    {
+                        c.second._cut = outer_cut;
+                        return parser_out<std::string>(std::unique_ptr<std::string>(), c.second);
+                    }
                     ps.fault(c.second._pfd._what, false);
+                    ps._pfd._reason = c.second._pfd._reason;
+                    ps._cut = outer_cut;
                     return parser_out<std::string>(std::unique_ptr<std::string>(), ps);
                 }
                 while (c.second.is_valid())
                 {
                     out.push_back(*c.first);
                     ps = c.second;
+                    ps._cut = false;
                     c = subparser(ps);
                 }
+                if (c.second._cut)
+                {
+                    c.second._cut = outer_cut;
+                    return parser_out<std::string>(std::unique_ptr<std::string>(), c.second);
+                }
+                ps._cut = outer_cut;
                 return parser_out<std::string>(std::make_unique<std::string>(out), ps);
             }};
 }
@@ -105,6 +132,65 @@ parser_type<bool> is_valid{[](parsing_state ps)
                            {
                                ps._pfd._valid = true;
                                ps._pfd._what = "";
+                               ps._pfd._reason = "";
                                ps._pfd._fault_point = data_stream();
                                return parser_out<bool>(std::make_unique<bool>(ps.is_valid()), ps);
-                           }};
\ No newline at end of file
+                           }};
+
+size_t digit_run(const char* p, const char* end)
+{
+    const char* q = p;
+    while ((!end || q < end) && static_cast<unsigned char>(*q - '0') < 10) ++q;
+    return q - p;
+}
+
+uint32_t parse_8digits(const char* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof v);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    v -= 0x3030303030303030;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+    return static_cast<uint32_t>(v);
+}
+
+//the extent of the number is found first so std::from_chars gets a bounded range
+parser_type<double> p_double{[](parsing_state ps)
+                             {
+                                 data_stream &ds = ps._ds;
+                                 if (!ds) return fail<double>("no parsing data")(ps);
+                                 if (!ps.is_valid()) return fail<double>("invalid state")(ps);
+                                 const char* begin = ds.ptr();
+                                 const char* end = ds.end();
+                                 auto at = [&ds](const char* q) { return ds.past_end(q) ? '\0' : *q; };
+                                 const char* p = begin;
+                                 if (at(p) == '+' || at(p) == '-') ++p;
+                                 size_t int_digits = digit_run(p, end);
+                                 p += int_digits;
+                                 size_t frac_digits = 0;
+                                 if (at(p) == '.')
+                                 {
+                                     frac_digits = digit_run(p + 1, end);
+                                     if (int_digits + frac_digits) p += 1 + frac_digits;
+                                 }
+                                 if (int_digits + frac_digits == 0) return fail<double>("expected number")(ps);
+                                 if (at(p) == 'e' || at(p) == 'E')
+                                 {
+                                     const char* e = p + 1;
+                                     if (at(e) == '+' || at(e) == '-') ++e;
+                                     size_t exp_digits = digit_run(e, end);
+                                     if (exp_digits) p = e + exp_digits;
+                                 }
+                                 ds.past_end(p);    //digits running up to the end of bounded input may go on after it
+                                 double value = 0;
+                                 //from_chars does not accept a leading +
+                                 auto result = std::from_chars(begin + (at(begin) == '+'), p, value);
+                                 if (result.ec == std::errc::result_out_of_range) return fail<double>("number out of range")(ps);
+                                 if (result.ec != std::errc()) return fail<double>("expected number")(ps);
+                                 ds.skip(result.ptr - begin);
+                                 return parser_out<double>(std::make_unique<double>(value), ps);
+                             }};
@@ -1,9 +1,15 @@
 #ifndef PARSING_H
 #define PARSING_H
 
+#include <algorithm>
+#include <istream>
+#include <optional>
 #include <sstream>
+#include <string>
 #include <vector>
 #include <functional>
+#include <limits>
+#include <type_traits>
 #include "bind_fst.h"
 #include "data_stream.h"
 #include "Maybe.h"
@@ -24,7 +30,7 @@ template<class T> using parser_out = std::pair<std::unique_ptr<T>, parsing_state
 template<class T> using parser_type = std::function<parser_out<T>(parsing_state)>;
 
 template<class T>
-Maybe<T> run_parser(const parser_type<T> &parser, const char *input)
+Maybe<T> run_parser(const parser_type<T> &parser, const data_stream &input)
 {
     auto result = parser(parsing_state(input, parsing_fault_data(true)));
     auto state = result.second;
@@ -34,6 +40,72 @@ Maybe<T> run_parser(const parser_type<T> &parser, const char *input)
     return Maybe<T>::Left(s.str());
 }
 
+template<class T>
+Maybe<T> run_parser(const parser_type<T> &parser, const char *input)
+{
+    return run_parser(parser, data_stream(input));
+}
+
+//binary-safe form: input is exactly length bytes and may contain '\0'
+template<class T>
+Maybe<T> run_parser(const parser_type<T> &parser, const char *input, size_t length)
+{
+    return run_parser(parser, data_stream(input, length));
+}
+
+//fault reported by the error-recovery mode
+struct parsing_fault
+{
+    int line = 0, column = 0;
+    std::string what;   //reason only, the position is line and column
+};
+
+template<class T>
+struct recovery_result
+{
+    Maybe<T> value;                     //partial result, Left only if the parse could not be resynchronized
+    std::vector<parsing_fault> faults;  //every fault in input order
+};
+
+/*
+ * runs a parser built with recover(): faults skipped by recover() do not stop the run,
+ * so all of them are found in a single pass
+ */
+template<class T>
+recovery_result<T> run_parser_recovering(const parser_type<T> &parser, const data_stream &input)
+{
+    auto result = parser(parsing_state(input, parsing_fault_data(true)));
+    const parsing_state &state = result.second;
+    recovery_result<T> out;
+    for (auto f = state._recovered; f; f = f->previous)
+    {
+        out.faults.push_back({f->fault._fault_point.line(), f->fault._fault_point.pos(), f->fault._reason});
+    }
+    std::reverse(out.faults.begin(), out.faults.end());
+    if (state.is_valid())
+    {
+        out.value = Maybe<T>::Right(std::move(*result.first));
+        return out;
+    }
+    out.faults.push_back({state._pfd._fault_point.line(), state._pfd._fault_point.pos(), state._pfd._reason});
+    std::stringstream s;
+    s << "parsing fail:\n" << state;
+    out.value = Maybe<T>::Left(s.str());
+    return out;
+}
+
+template<class T>
+recovery_result<T> run_parser_recovering(const parser_type<T> &parser, const char *input)
+{
+    return run_parser_recovering(parser, data_stream(input));
+}
+
+template<class T>
+recovery_result<T> run_parser_recovering(const parser_type<T> &parser, const char *input, size_t length)
+{
+    return run_parser_recovering(parser, data_stream(input, length));
+}
+
 //functor
 
 /*
@@ -199,13 +271,23 @@ parser_type<std::vector<T>> many(const parser_type<T> &subparser)
     return {[&](parsing_state ps)
             {
                 std::vector<T> out;
+                bool outer_cut = ps._cut;
+                ps._cut = false;
                 parser_out<T> c = subparser(ps);
                 while (c.second.is_valid())
                 {
                     out.push_back(*c.first);
                     ps = c.second;
+                    ps._cut = false;
                     c = subparser(ps);
                 }
+                //an entry that failed after its cut is an error, not the end of the list
+                if (c.second._cut)
+                {
+                    c.second._cut = outer_cut;
+                    return parser_out<std::vector<T>>(std::unique_ptr<std::vector<T>>(), c.second);
+                }
+                ps._cut = outer_cut;
                 return parser_out<std::vector<T>>(std::make_unique<std::vector<T>>(out), ps);
             }};
 }
@@ -233,6 +315,80 @@ parser_type<std::string> p_until(const parser_type<T> &subparser)
 
 extern parser_type<char> any_char;
 
+//length of the run of ASCII digits at p, bounded by end or by the terminating '\0' if end is nullptr
+size_t digit_run(const char *p, const char *end);
+
+//converts exactly 8 ASCII digits at p at once (SWAR)
+uint32_t parse_8digits(const char *p);
+
+//converts n ASCII digits at p, false on overflow of U
+template<class U>
+bool parse_digits(const char *p, size_t n, U &value)
+{
+    static_assert(std::is_unsigned_v<U>);
+    value = 0;
+    if constexpr (std::numeric_limits<U>::digits >= 27)
+    {
+        for (; n >= 8; p += 8, n -= 8)
+        {
+            U chunk = parse_8digits(p);
+            if (value > (std::numeric_limits<U>::max() - chunk) / 100000000u) return false;
+            value = value * 100000000u + chunk;
+        }
+    }
+    for (; n > 0; ++p, --n)
+    {
+        U digit = *p - '0';
+        if (value > (std::numeric_limits<U>::max() - digit) / 10u) return false;
+        value = static_cast<U>(value * 10u + digit);
+    }
+    return true;
+}
+
+//parse a decimal number without sign into the integral type T, fails on overflow
+template<class T>
+parser_type<T> p_uint{[](parsing_state ps)
+                      {
+                          static_assert(std::is_integral_v<T>);
+                          if (!ps._ds) return fail<T>("no parsing data")(ps);
+                          if (!ps.is_valid()) return fail<T>("invalid state")(ps);
+                          const char *p = ps._ds.ptr();
+                          size_t n = digit_run(p, ps._ds.end());
+                          ps._ds.past_end(p + n);   //digits running up to the end of bounded input may go on after it
+                          if (n == 0) return fail<T>("expected digit")(ps);
+                          std::make_unsigned_t<T> value;
+                          if (!parse_digits(p, n, value) || value > std::make_unsigned_t<T>(std::numeric_limits<T>::max()))
+                              return fail<T>("integer overflow")(ps);
+                          ps._ds.skip(n);
+                          return parser_out<T>(std::make_unique<T>(static_cast<T>(value)), ps);
+                      }};
+
+//parse a decimal number with optional + or - into the integral type T, fails on overflow
+template<class T>
+parser_type<T> p_int{[](parsing_state ps)
+                     {
+                         static_assert(std::is_integral_v<T>);
+                         using U = std::make_unsigned_t<T>;
+                         if (!ps._ds) return fail<T>("no parsing data")(ps);
+                         if (!ps.is_valid()) return fail<T>("invalid state")(ps);
+                         const char *begin = ps._ds.ptr();
+                         bool negative = *ps._ds == '-';
+                         size_t sign = (negative || *ps._ds == '+') ? 1 : 0;
+                         size_t n = digit_run(begin + sign, ps._ds.end());
+                         ps._ds.past_end(begin + sign + n);
+                         if (n == 0) return fail<T>("expected digit")(ps);
+                         U value;
+                         U limit = U(std::numeric_limits<T>::max()) + ((negative && std::is_signed_v<T>) ? 1u : 0u);
+                         if (!parse_digits(begin + sign, n, value) || value > limit || (negative && !std::is_signed_v<T> && value))
+                             return fail<T>("integer overflow")(ps);
+                         ps._ds.skip(sign + n);
+                         T out = negative ? static_cast<T>(U(0) - value) : static_cast<T>(value);
+                         return parser_out<T>(std::make_unique<T>(out), ps);
+                     }};
+
+//parse a decimal floating point number: [+-]digits[.digits][(e|E)[+-]digits]
+extern parser_type<double> p_double;
+
 extern parser_type<bool> is_valid;
 
 template<class T>
@@ -245,20 +401,168 @@ function<parser_type<T>(bool)> p_if(const parser_type<T> &trueval, const parser_
                     });
 }
 
+//alternatives get a fresh cut scope: a cut passed inside p1 stops p2 from being tried, and nothing more
 template<class T>
 parser_type<T> operator||(const parser_type<T> &p1, const parser_type<T> &p2)
 {
     return {[&](parsing_state ps)
             {
+                bool outer_cut = ps._cut;
+                ps._cut = false;
                 parser_out<T> test1 = p1(ps);
-                if (test1.second.is_valid()) return test1;
+                if (test1.second.is_valid() || test1.second._cut)
+                {
+                    test1.second._cut = outer_cut;
+                    return test1;
+                }
                 parser_out<T> test2 = p2(ps);
-                if (test2.second.is_valid()) return test2;
+                if (test2.second.is_valid() || test2.second._cut)
+                {
+                    test2.second._cut = outer_cut;
+                    return test2;
+                }
                 std::stringstream ss;
                 ss << test1.second << "\nor\n" << test2.second;
                 ps.fault(ss.str(), false);
+                ps._cut = outer_cut;
                 return parser_out<T>(std::unique_ptr<T>(), ps);
             }};
 }
 
+/*
+ * cut (PEG commit)
+ * once p has matched, the nearest enclosing || and many no longer backtrack past this point:
+ * a later failure is reported as is instead of trying the other alternatives.
+ * the fault bookkeeping collected so far is dropped.
+ */
+template<class T>
+parser_type<T> commit(const parser_type<T> &p)
+{
+    return {[p](parsing_state ps)
+            {
+                parser_out<T> out = p(ps);
+                if (out.second.is_valid())
+                {
+                    out.second._pfd = parsing_fault_data(true);
+                    out.second._cut = true;
+                }
+                return out;
+            }};
+}
+
+//short form of commit
+template<class T>
+parser_type<T> operator~(const parser_type<T> &p)
+{
+    return commit(p);
+}
+
+//consumes characters until p matches, then p itself; returns the value of p
+template<class T>
+parser_type<T> skip_until(const parser_type<T> &p)
+{
+    return {[p](parsing_state ps)
+            {
+                for (;;)
+                {
+                    parser_out<T> test = p(ps);
+                    if (test.second.is_valid()) return test;
+                    if (ps.is_EOF()) return fail<T>("end of input while resynchronizing")(ps);
+                    ++ps._ds;
+                }
+            }};
+}
+
+/*
+ * error recovery
+ * if p fails, its fault is recorded in the state, sync is run from where p started
+ * and the parse goes on with an empty value. sync always moves the input forward,
+ * so many(recover(...)) cannot loop. Fails as p did if sync does not match either.
+ */
+template<class T, class S>
+parser_type<std::optional<T>> recover(const parser_type<T> &p, const parser_type<S> &sync)
+{
+    return {[p, sync](parsing_state ps)
+            {
+                parser_out<T> attempt = p(ps);
+                if (attempt.second.is_valid())
+                {
+                    auto value = std::make_unique<std::optional<T>>(std::move(*attempt.first));
+                    return parser_out<std::optional<T>>(std::move(value), attempt.second);
+                }
+                parser_out<S> skipped = sync(ps);
+                parsing_state next = skipped.second;
+                if (!next.is_valid() || (next._ds.ptr() == ps._ds.ptr() && ps.is_EOF()))
+                    return parser_out<std::optional<T>>(std::unique_ptr<std::optional<T>>(), attempt.second);
+                if (next._ds.ptr() == ps._ds.ptr()) ++next._ds;
+                parsing_fault_data fault = attempt.second._pfd;
+                if (!fault._fault_point) fault._fault_point = ps._ds;
+                next._recovered = std::make_shared<const recovered_fault>(recovered_fault{fault, next._recovered});
+                return parser_out<std::optional<T>>(std::make_unique<std::optional<T>>(), next);
+            }};
+}
+
+/*
+ * parses a long stream of records with bounded memory
+ * the input is read in chunks; every record that matches is handed to on_record and its bytes are released,
+ * so only the unparsed tail stays buffered. A result that did not look at the end of the buffered data
+ * is final; one that did is redone after reading more, since the next chunk may change it.
+ * A record failing after passing a commit (cut) before the end of the buffered data is malformed and stops
+ * the run at once: the cut, not the record boundary, is what lets a failing parse give up its bytes.
+ * Without one, a failure that ran into the buffer end keeps the tail buffered; once more than max_record
+ * unreleased bytes wait that way, the run stops with a fault.
+ * Returns the number of records or the fault message (its position counts from the first unreleased record).
+ */
+template<class T, class F>
+Maybe<size_t> run_parser_records(const parser_type<T> &record, std::istream &in, F on_record, size_t chunk = 1 << 16,
+                                 size_t max_record = 1 << 24)
+{
+    std::string buffer;
+    size_t begin = 0, count = 0;
+    bool input_end = false;
+    for (;;)
+    {
+        if (begin < buffer.size())
+        {
+            bool end_seen = false;
+            data_stream ds(buffer.data() + begin, buffer.size() - begin);
+            ds.watch_end(&end_seen);
+            parser_out<T> result = record(parsing_state(ds, parsing_fault_data(true)));
+            const parsing_state &state = result.second;
+            bool final = !end_seen || input_end;
+            if (state.is_valid() && final)
+            {
+                if (state._ds.ptr() == ds.ptr()) return Maybe<size_t>::Left("parsing fail:\nrecord parser consumed no input");
+                on_record(std::move(*result.first));
+                ++count;
+                begin = state._ds.ptr() - buffer.data();
+                continue;
+            }
+            bool committed = !state.is_valid() && state._cut &&
+                             state._pfd._fault_point.ptr() < buffer.data() + buffer.size();
+            if (!state.is_valid() && (final || committed))
+            {
+                std::stringstream s;
+                s << "parsing fail:\n" << state;
+                return Maybe<size_t>::Left(s.str());
+            }
+            if (buffer.size() - begin >= max_record)
+            {
+                std::stringstream s;
+                s << "parsing fail:\n" << ds << ": record longer than " << max_record << " bytes";
+                return Maybe<size_t>::Left(s.str());
+            }
+        }
+        else if (input_end) return Maybe<size_t>::Right(std::move(count));
+        //release parsed records, then read more
+        buffer.erase(0, begin);
+        begin = 0;
+        size_t old_size = buffer.size();
+        buffer.resize(old_size + chunk);
+        in.read(buffer.data() + old_size, static_cast<std::streamsize>(chunk));
+        buffer.resize(old_size + static_cast<size_t>(in.gcount()));
+        input_end = !in;
+    }
+}
+
 #endif /***PARSING_H***/
\ No newline at end of file
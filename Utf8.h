@@ -0,0 +1,67 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstring>
+#include "Parsing.h"
+
+/*
+ * UTF-8 mode
+ * the input is validated once up front, after that columns are counted in code points
+ * and the code point parsers below can be mixed freely with the byte-level ones:
+ * ASCII text is still matched byte by byte by p_char, p_string and the rest.
+ */
+
+//decodes one code point at p from at most avail bytes, returns its length or 0 if the sequence is invalid
+size_t utf8_decode(const char *p, size_t avail, char32_t &cp);
+
+//checks the whole input, on failure returns false and the offset of the first invalid byte
+bool utf8_validate(const char *data, size_t length, size_t &error_offset);
+
+//character classes of the Unicode 14.0 database: letters (L*), decimal digits (Nd), combining marks (Mn, Mc)
+bool is_uletter(char32_t cp);
+
+bool is_udigit(char32_t cp);
+
+bool is_umark(char32_t cp);
+
+bool is_uspace(char32_t cp);
+
+//parse any code point
+extern parser_type<char32_t> p_codepoint;
+
+//parse a code point obeying the predicate
+parser_type<char32_t> p_codepoint_if(const function<bool(char32_t)> &predicate, const std::string &description);
+
+extern parser_type<char32_t> p_uletter;
+
+extern parser_type<char32_t> p_udigit;
+
+//letter, combining mark or digit: the marks are needed to spell words in scripts such as Devanagari or Thai
+extern parser_type<char32_t> p_ualnum;
+
+extern parser_type<char32_t> p_uspace;
+
+//validates the input and runs the parser in UTF-8 mode
+template<class T>
+Maybe<T> run_parser_utf8(const parser_type<T> &parser, const char *input, size_t length)
+{
+    data_stream ds(input, length);
+    ds.set_utf8(true);
+    size_t error_offset = 0;
+    if (!utf8_validate(input, length, error_offset))
+    {
+        ds.skip(error_offset);
+        std::stringstream s;
+        s << "parsing fail:\n" << ds << ": invalid UTF-8";
+        return Maybe<T>::Left(s.str());
+    }
+    return run_parser(parser, ds);
+}
+
+template<class T>
+Maybe<T> run_parser_utf8(const parser_type<T> &parser, const char *input)
+{
+    return run_parser_utf8(parser, input, strlen(input));
+}
+
+#endif /***UTF8_H***/
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <sstream>
 #include "data_stream.h"
 
@@ -6,11 +7,16 @@ data_stream::data_stream(const char* data) : _data_ptr(data), _line(1), _pos(1)
 
 }
 
+data_stream::data_stream(const char* data, size_t length) : _data_ptr(data), _end(data + length), _line(1), _pos(1)
+{
+
+}
+
 char data_stream::operator++()
 {
-    if ((_data_ptr != nullptr) && *_data_ptr != '\0')
+    if (!at_end())
     {
-        ++_pos;
+        if (!_utf8 || (static_cast<unsigned char>(*_data_ptr) & 0xC0) != 0x80) ++_pos;
         if (*_data_ptr == '\n')
         {
             _pos = 1;
@@ -21,9 +27,65 @@ char data_stream::operator++()
     return '\0';
 }
 
+void data_stream::skip(size_t n)
+{
+    const char* end = _data_ptr + n;
+    while (const char* nl = static_cast<const char*>(memchr(_data_ptr, '\n', end - _data_ptr)))
+    {
+        _data_ptr = nl + 1;
+        _pos = 1;
+        ++_line;
+    }
+    if (_utf8)
+    {
+        for (; _data_ptr < end; ++_data_ptr)
+        {
+            if ((static_cast<unsigned char>(*_data_ptr) & 0xC0) != 0x80) ++_pos;
+        }
+        return;
+    }
+    _pos += static_cast<int>(end - _data_ptr);
+    _data_ptr = end;
+}
+
+void data_stream::jump(size_t n)
+{
+    _data_ptr += n;
+    _pos += static_cast<int>(n);
+}
+
+bool data_stream::note_end(bool at) const
+{
+    if (at && _end_seen) *_end_seen = true;
+    return at;
+}
+
+bool data_stream::at_end() const
+{
+    if (!_data_ptr) return true;
+    if (_end) return note_end(_data_ptr >= _end);
+    return *_data_ptr == '\0';
+}
+
+bool data_stream::has(size_t n) const
+{
+    if (!_data_ptr) return false;
+    if (_end) return !note_end(static_cast<size_t>(_end - _data_ptr) < n);
+    return memchr(_data_ptr, '\0', n) == nullptr;
+}
+
+data_stream data_stream::limit(size_t n) const
+{
+    data_stream out(*this);
+    out._end = _data_ptr + n;
+    //конец укороченной копии - не конец ввода
+    if (out._end != _end) out._end_seen = nullptr;
+    return out;
+}
+
 char data_stream::operator*() const
 {
-    if (_data_ptr) return *_data_ptr;
+    if (!at_end()) return *_data_ptr;
     return '\0';
 }
 
@@ -40,6 +102,9 @@ data_stream::operator bool() const
 data_stream::data_stream(const data_stream& other)
 {
     _data_ptr = other._data_ptr;
+    _end = other._end;
+    _utf8 = other._utf8;
+    _end_seen = other._end_seen;
     _line = other._line;
     _pos = other._pos;
 }
@@ -65,7 +130,7 @@ std::ostream& operator<<(std::ostream& o, const data_stream& data)
 {
     if (data._data_ptr)
     {
-        if (*data._data_ptr) o << "(" << data._line << ":" << data._pos << ") : " << *data._data_ptr;
+        if (!data.at_end()) o << "(" << data._line << ":" << data._pos << ") : " << *data._data_ptr;
         else o << "(" << data._line << ":" << data._pos << ") : " << "EOF";
     }
     else o << "stream invalid";
@@ -87,6 +152,14 @@ bool parsing_state::is_valid() const
 }
 
 parsing_state parsing_state::join(const parsing_state& initial, const parsing_state& result)
+{
+    parsing_state out = join_streams(initial, result);
+    out._cut = initial._cut || result._cut;
+    out._recovered = result._recovered ? result._recovered : initial._recovered;
+    return out;
+}
+
+parsing_state parsing_state::join_streams(const parsing_state& initial, const parsing_state& result)
 {
     if (result.is_valid()) return {data_stream::combine(initial._ds, result._ds, 0), parsing_fault_data(true)};
     if (initial.is_valid()) return {data_stream::combine(initial._ds, result._ds, -1), result._pfd};
@@ -103,6 +176,14 @@ parsing_state parsing_state::join(const parsing_state& initial, const parsing_st
 }
 
 parsing_state parsing_state::both(const parsing_state& ps1, const parsing_state& ps2)
+{
+    parsing_state out = both_streams(ps1, ps2);
+    out._cut = ps1._cut || ps2._cut;
+    out._recovered = ps2._recovered ? ps2._recovered : ps1._recovered;
+    return out;
+}
+
+parsing_state parsing_state::both_streams(const parsing_state& ps1, const parsing_state& ps2)
 {
     if (ps1.is_valid() || ps2.is_valid())
     {
@@ -145,11 +226,18 @@ void parsing_state::fault(const std::string& why, bool add_ds)
     if (add_ds) ss << _ds << ": ";
     ss << why;
     _pfd = {ss.str(), _ds};
+    _pfd._reason = why;
+}
+
+recovered_fault::~recovered_fault()
+{
+    std::shared_ptr<const recovered_fault> next = std::move(previous);
+    while (next && next.use_count() == 1) next = std::move(next->previous);
 }
 
 bool parsing_state::is_EOF() const
 {
-    return *_ds == '\0';
+    return _ds.at_end();
 }
 
 std::ostream& operator<<(std::ostream& o, const parsing_fault_data& data)
@@ -2,6 +2,7 @@
 #define DATA_STREAM_H
 
 #include <iostream>
+#include <memory>
 
 /*
  * класс навигации по данным todo: организовать через std::ostream
@@ -9,13 +10,22 @@
 class data_stream
 {
     const char* _data_ptr = nullptr;//скользящий указатель на текущую позицию
+    const char* _end = nullptr;     //конец ввода известной длины, nullptr - ввод заканчивается на '\0'
     int _line = -1;                 //строка
     int _pos = -1;                  //символ в строке
+    bool _utf8 = false;             //считать позицию в строке в кодовых точках UTF-8, а не в байтах
+    bool* _end_seen = nullptr;      //флаг, который поднимается, когда парсер упирается в _end (см. watch_end)
+
+    //поднимает _end_seen, если at - парсер упёрся в конец ввода
+    bool note_end(bool at) const;
 public:
     data_stream() = default;
 
     data_stream(const char* data);
 
+    //ввод известной длины: '\0' внутри него - обычный байт
+    data_stream(const char* data, size_t length);
+
     data_stream(const data_stream& other);
 
     //проверяет что класс инициализирован
@@ -27,6 +37,43 @@ public:
     //выбирает символ оставляя указатель где был
     char operator*() const;
 
+    int line() const { return _line; }
+
+    int pos() const { return _pos; }
+
+    //текущий указатель на данные - для парсеров, работающих со смещениями во вводе
+    const char* ptr() const { return _data_ptr; }
+
+    //конец ввода известной длины либо nullptr
+    const char* end() const { return _end; }
+
+    //режим UTF-8: продолжающие байты (10xxxxxx) не увеличивают позицию в строке
+    void set_utf8(bool on) { _utf8 = on; }
+
+    bool is_utf8() const { return _utf8; }
+
+    //*seen становится true, как только этот поток или его копии упрутся в конец ввода известной длины:
+    //значит, результат разбора мог зависеть от того, что идёт дальше (чтение ввода по частям)
+    void watch_end(bool* seen) { _end_seen = seen; }
+
+    //для парсеров, читающих через ptr()/end(): лежит ли p в конце ввода известной длины или за ним
+    bool past_end(const char* p) const { return note_end(_end && p >= _end); }
+
+    //сдвигает указатель сразу на n символов, n не должен выходить за конец ввода
+    void skip(size_t n);
+
+    //сдвигает указатель на n байт за O(1), не разбирая строки - для двоичных данных
+    void jump(size_t n);
+
+    //достигнут ли конец ввода
+    bool at_end() const;
+
+    //есть ли впереди ещё хотя бы n байт
+    bool has(size_t n) const;
+
+    //копия, видящая только следующие n байт (n <= оставшихся)
+    data_stream limit(size_t n) const;
+
     //показывает какой из инстансов указывает дальше todo: предусмотреть ситуацию сравнения разных строк
     bool operator>(const data_stream& o) const;
 
@@ -52,6 +99,7 @@ struct parsing_fault_data
 {
     bool _valid = false;
     std::string _what {"null object"};
+    std::string _reason {"null object"};   //_what без позиции в начале - для вывода, где позиция пишется отдельно
     data_stream _fault_point;
 
     parsing_fault_data() = default;
@@ -61,6 +109,16 @@ struct parsing_fault_data
     friend std::ostream& operator<<(std::ostream& o, const parsing_fault_data& data);
 };
 
+//ошибка, пропущенная в режиме восстановления (recover); список неизменяемый, поэтому копирование состояния дешевое
+struct recovered_fault
+{
+    parsing_fault_data fault;
+    mutable std::shared_ptr<const recovered_fault> previous;   //mutable - чтобы деструктор мог отцепить хвост
+
+    //освобождает хвост списка в цикле: рекурсивное удаление миллионов узлов переполняет стек
+    ~recovered_fault();
+};
+
 /*
  * класс состояния парсера
  */
@@ -69,6 +127,8 @@ class parsing_state
 public:
     parsing_fault_data _pfd;
     data_stream _ds;
+    bool _cut = false;  //пройдена точка отсечения (commit): ближайший выбор больше не пробует альтернативы
+    std::shared_ptr<const recovered_fault> _recovered;  //ошибки, пропущенные recover, последняя - первой
 
     parsing_state(const data_stream& ds, const parsing_fault_data &pfd);
 
@@ -85,6 +145,12 @@ public:
     void fault(const std::string& why, bool ass_ds);
 
     friend std::ostream& operator<<(std::ostream& o, const parsing_state& ps);
+
+private:
+    //join и both без учёта отсечения и пропущенных ошибок - они переносятся отдельно
+    static parsing_state join_streams(const parsing_state& initial, const parsing_state& result);
+
+    static parsing_state both_streams(const parsing_state& ps1, const parsing_state& ps2);
 };
 
 #endif /***DATASTREAM_H***/
\ No newline at end of file